@@ -1,6 +1,6 @@
 /*
  * Date Created: 10/08/24
- * Last Modified: 14/09/24
+ * Last Modified: 18/10/26
  *
  * Source file for EPS fault detection: chronic_idle
  * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
@@ -14,10 +14,16 @@
 #include "load_switches.h"
 #include "pwr_mon_read_error.h"
 #include "source_decay.h"
-
-static uint16_t pass_num = 0; //Main loop iteration counter regularly prompting system checks
-static uint8_t consecutive_idles = 0; //Bitfield tracking recent MPPT idles; 0xFF means persistent idle
-static uint8_t mppt_was_reset = FALSE; //Flag for recent MPPT resets by 'handle_chronic_idle'
+#include "detector_state.h"
+#include "read_trace.h"
+#include "recovery_queue.h"
+#include "fault_correlation.h"
+#include "fault_sections.h"
+
+FAULT_HOT_RODATA const uint16_t g_const_PASS_REQ = 7999; //Placeholder: number of loop iterations for ~1 minute delay
+FAULT_HOT_RODATA const float TEMP_CONVERT_FAC = 0.125; //Data sheet conversion factor in [°C/LSB]
+FAULT_HOT_RODATA const float VOLT_CONVERT_FAC = 3.125; //Data sheet conversion factor in [mV/LSB]
+static chronic_idle_state_t *const state = &g_detector_state.chronic_idle; //Persistent counters and flags, see 'detector_state.h'
 static const float DAYLIGHT_TEMP_LIM = 50; //Tentative sunlight exposure threshold
 static const float DAYLIGHT_VOLT_LIM = 0; //Tentative sunlight exposure threshold
 
@@ -29,7 +35,7 @@ static const float DAYLIGHT_VOLT_LIM = 0; //Tentative sunlight exposure threshol
   *
   * @retval temperature in degrees Celsius
 */
-float convert_raw_to_celsius(int16_t raw_temp_val){
+FAULT_HOT_CODE float convert_raw_to_celsius(int16_t raw_temp_val){
 
     float temperature_celsius = raw_temp_val * TEMP_CONVERT_FAC;
 
@@ -49,6 +55,8 @@ int8_t check_if_in_daylight_temp(){
 
     char out_message[50];
     int16_t raw_temp_val = eps_get_power_monitor_temp_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    read_trace_record(READ_TRACE_SRC_TEMP, raw_temp_val, out_message);
+    fault_corr_observe(PWR_MON_REG_TEMP, FAULT_CORR_CHRONIC_IDLE, out_message);
 
     if (strcmp(out_message, "ERRORT\r\n") == 0){
         
@@ -71,7 +79,7 @@ int8_t check_if_in_daylight_temp(){
   *
   * @retval power monitor shunt voltage in millivolts
 */
-float convert_raw_to_mv(int16_t raw_volt_val){
+FAULT_HOT_CODE float convert_raw_to_mv(int16_t raw_volt_val){
 
     float voltage_mv = raw_volt_val * VOLT_CONVERT_FAC;
 
@@ -91,6 +99,8 @@ int8_t check_if_in_daylight_volt(){
 
     char out_message[50];
     int16_t raw_volt_val = eps_get_power_monitor_v_bus_val_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    read_trace_record(READ_TRACE_SRC_V_BUS, raw_volt_val, out_message);
+    fault_corr_observe(PWR_MON_REG_V_BUS, FAULT_CORR_CHRONIC_IDLE, out_message);
 
     if (strcmp(out_message, "ERRORT\r\n") == 0){
         return ERROR;
@@ -113,32 +123,33 @@ int8_t check_if_in_daylight_volt(){
   *
   * @retval None
 */
-void detect_chronic_idle(){
+FAULT_HOT_CODE void detect_chronic_idle(){
 
-    if (pass_num <= g_const_PASS_REQ / (g_source_decay + 1) ) {
-        pass_num++;
+    if (state->pass_num <= g_const_PASS_REQ / (g_source_decay + 1) ) {
+        state->pass_num++;
 
     } else {
         eps_mppt_status out = mppt_get_charge_status();
+        read_trace_record(READ_TRACE_SRC_MPPT, out, NULL);
 
         if (out == EPS_MPPT_CHARGING_IDLE) {
 
-            consecutive_idles = (consecutive_idles << 1) | 1;
+            state->consecutive_idles = (state->consecutive_idles << 1) | 1;
             
-            if (consecutive_idles == 0xFF) {
+            if (state->consecutive_idles == 0xFF) {
                 handle_chronic_idle();
             }
 
         } else {
-            consecutive_idles = 0;
-            mppt_was_reset = FALSE;
+            state->consecutive_idles = 0;
+            state->mppt_was_reset = FALSE;
         }
-        pass_num = 0;
+        state->pass_num = 0;
     }
 }
 
 /**
-  * @brief runs helper functions, power cycles mppt if necessary
+  * @brief runs helper functions, queues an mppt power cycle or safety mode entry if necessary
   *
   * @param None
   *
@@ -146,7 +157,7 @@ void detect_chronic_idle(){
 */
 void handle_chronic_idle(){
 
-    if (mppt_was_reset == FALSE){
+    if (state->mppt_was_reset == FALSE){
 
         int8_t temp_check = check_if_in_daylight_temp();
         int8_t volt_check = check_if_in_daylight_volt();
@@ -155,12 +166,11 @@ void handle_chronic_idle(){
             g_read_error = TRUE;
 
         } else if (temp_check == TRUE && volt_check == TRUE){
-            mppt_init();
-            mppt_was_reset = TRUE;
+            recovery_post(RECOVERY_MPPT_REINIT);
+            state->mppt_was_reset = TRUE;
         }
-    } else if (mppt_was_reset == TRUE){
+    } else if (state->mppt_was_reset == TRUE){
         
-        printf("Entering Safety Mode\n");
-        printf("Fault: chronic_idle\n");
+        recovery_post(RECOVERY_SAFETY_MODE_CHRONIC_IDLE);
     }
 }
@@ -1,6 +1,6 @@
 /*
  * Date Created: 15/08/24
- * Last Modified: 14/09/24
+ * Last Modified: 18/10/26
  *
  * Header file for EPS fault detection: chronic_idle
  * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
@@ -17,12 +17,17 @@
 #define SECONDARY_DEVICE_ADDRESS 0x00 //Placeholder: address depends on hardware configuration
 #define POWER_MONITOR_ADDRESS 0 //Placeholder: address depends on hardware configuration
 
-const uint16_t g_const_PASS_REQ = 7999; //Placeholder: number of loop iterations for ~1 minute delay
-const float TEMP_CONVERT_FAC = 0.125; //Data sheet conversion factor in [°C/LSB]
-const float VOLT_CONVERT_FAC = 3.125; //Data sheet conversion factor in [mV/LSB]
-const uint8_t TRUE = 1;
-const uint8_t FALSE = 0;
-const int8_t ERROR = -1;
+//Defined once in 'chronic_idle.c'
+extern const uint16_t g_const_PASS_REQ; //Placeholder: number of loop iterations for ~1 minute delay
+extern const float TEMP_CONVERT_FAC; //Data sheet conversion factor in [°C/LSB]
+extern const float VOLT_CONVERT_FAC; //Data sheet conversion factor in [mV/LSB]
+
+//Compile-time status values; no storage in any translation unit
+enum {
+    TRUE = 1,
+    FALSE = 0,
+    ERROR = -1
+};
 
 
 /************** FUNCTION DEFS **************/
@@ -76,7 +81,7 @@ float convert_raw_to_mv(int16_t raw_volt_val);
 int8_t check_if_in_daylight_volt();
 
 /**
-  * @brief runs helper functions, power cycles mppt if necessary
+  * @brief runs helper functions, queues an mppt power cycle or safety mode entry if necessary
   *
   * @param None
   *
@@ -0,0 +1,220 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Source file for EPS fault detection: detector_state
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Consolidates the state of every fault detector into one versioned, checksummed struct which is
+ * checkpointed to battery-backed SRAM so detection windows survive brownouts and watchdog resets.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#include "detector_state.h"
+#include "fault_sections.h"
+#include <stddef.h>
+#include <string.h>
+
+#ifdef USE_HAL_DRIVER
+#include "main.h"
+//Backup SRAM (4KB at 0x40024000, kept alive by VBAT); the linker script must map '.bkpsram' there as NOLOAD
+#define BACKUP_SRAM __attribute__((section(".bkpsram")))
+#else
+#include <stdio.h>
+//Host stand-in for backup SRAM: the slots are mirrored to a file on every commit
+#define BACKUP_SRAM
+#ifndef DETECTOR_STATE_FILE
+#define DETECTOR_STATE_FILE "detector_state.bin"
+#endif
+#endif
+
+#define BACKUP_SLOT_COUNT 2 //Slots are written alternately so a reset mid-commit never loses both
+
+FAULT_HOT_DATA detector_state_t g_detector_state;
+static detector_state_t backup_slots[BACKUP_SLOT_COUNT] BACKUP_SRAM; //Survives resets; never zeroed by startup code
+static uint8_t next_slot = 0; //Slot which the next commit overwrites
+FAULT_HOT_DATA static uint16_t checkpoint_pass_num = 0; //Main loop iteration counter spacing out commits
+static const uint32_t crc_nibble_table[16] = { //CRC-32 (0xEDB88320) lookup, one entry per nibble
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+
+/**
+  * @brief computes the CRC-32 of a slot, excluding its trailing checksum field
+  *
+  * @param state detector state slot to checksum
+  *
+  * @retval CRC-32 of the slot
+*/
+static uint32_t compute_checksum(const detector_state_t *state){
+
+    const uint8_t *bytes = (const uint8_t *)state;
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < offsetof(detector_state_t, checksum); i++){
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ crc_nibble_table[crc & 0x0F];
+        crc = (crc >> 4) ^ crc_nibble_table[crc & 0x0F];
+    }
+
+    return ~crc;
+}
+
+/**
+  * @brief checks whether a backup slot holds a checkpoint written by this firmware version
+  *
+  * @param state detector state slot to validate
+  *
+  * @retval 1 or 0, in the case of TRUE or FALSE respectively
+*/
+static uint8_t slot_is_valid(const detector_state_t *state){
+
+    if (state->magic != DETECTOR_STATE_MAGIC || state->version != DETECTOR_STATE_VERSION
+            || state->size != sizeof(detector_state_t)){
+        return 0;
+    }
+
+    if (compute_checksum(state) != state->checksum){
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+  * @brief makes the backup slots accessible, loading them from the backing file on host
+  *
+  * @param None
+  *
+  * @retval None
+*/
+static void backup_open(){
+
+#ifdef USE_HAL_DRIVER
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    __HAL_RCC_BKPSRAM_CLK_ENABLE();
+    HAL_PWREx_EnableBkUpReg();
+#else
+    FILE *file = fopen(DETECTOR_STATE_FILE, "rb");
+
+    if (file == NULL){
+        memset(backup_slots, 0, sizeof(backup_slots));
+        return;
+    }
+
+    if (fread(backup_slots, sizeof(backup_slots), 1, file) != 1){
+        memset(backup_slots, 0, sizeof(backup_slots));
+    }
+    fclose(file);
+#endif
+}
+
+/**
+  * @brief flushes the backup slots to the backing file on host; no-op on target
+  *
+  * @param None
+  *
+  * @retval None
+*/
+static void backup_flush(){
+
+#ifndef USE_HAL_DRIVER
+    FILE *file = fopen(DETECTOR_STATE_FILE, "wb");
+
+    if (file != NULL){
+        fwrite(backup_slots, sizeof(backup_slots), 1, file);
+        fclose(file);
+    }
+#endif
+}
+
+/**
+  * @brief resets all detector state to its cold boot defaults
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void detector_state_reset(){
+
+    memset(&g_detector_state, 0, sizeof(g_detector_state));
+    g_detector_state.magic = DETECTOR_STATE_MAGIC;
+    g_detector_state.version = DETECTOR_STATE_VERSION;
+    g_detector_state.size = sizeof(detector_state_t);
+}
+
+/**
+  * @brief restores detector state from the newest valid backup slot; falls back to cold boot defaults
+  * if no slot passes the magic, version, size and checksum checks. Call once at boot before the main loop
+  *
+  * @param None
+  *
+  * @retval 0 or -1, indicating a warm restart or a cold boot respectively
+*/
+int8_t detector_state_restore(){
+
+    const detector_state_t *newest = NULL;
+
+    backup_open();
+    checkpoint_pass_num = 0;
+
+    for (uint8_t i = 0; i < BACKUP_SLOT_COUNT; i++){
+
+        if (slot_is_valid(&backup_slots[i])){
+
+            //Signed difference keeps the comparison correct across sequence wraparound
+            if (newest == NULL || (int32_t)(backup_slots[i].sequence - newest->sequence) > 0){
+                newest = &backup_slots[i];
+                next_slot = (i + 1) % BACKUP_SLOT_COUNT;
+            }
+        }
+    }
+
+    if (newest == NULL){
+
+        detector_state_reset();
+        next_slot = 0;
+        return -1;
+    }
+
+    memcpy(&g_detector_state, newest, sizeof(g_detector_state));
+    return 0;
+}
+
+/**
+  * @brief writes the live detector state to the older of the two backup slots
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void detector_state_commit(){
+
+    g_detector_state.sequence++;
+    g_detector_state.checksum = compute_checksum(&g_detector_state);
+
+    memcpy(&backup_slots[next_slot], &g_detector_state, sizeof(g_detector_state));
+    next_slot = (next_slot + 1) % BACKUP_SLOT_COUNT;
+
+    backup_flush();
+}
+
+/**
+  * @brief counts main loop passes, committing detector state once every 'interval' passes; call once per pass
+  *
+  * @param interval number of main loop passes between commits, e.g. g_const_PASS_REQ for ~1 minute
+  *
+  * @retval None
+*/
+FAULT_HOT_CODE void detector_state_checkpoint(uint16_t interval){
+
+    if (checkpoint_pass_num < interval){
+        checkpoint_pass_num++;
+
+    } else {
+        detector_state_commit();
+        checkpoint_pass_num = 0;
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Header file for EPS fault detection: detector_state
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Consolidates the state of every fault detector into one versioned, checksummed struct which is
+ * checkpointed to battery-backed SRAM so detection windows survive brownouts and watchdog resets.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#ifndef DETECTOR_STATE_H_
+#define DETECTOR_STATE_H_
+
+#include <stdint.h>
+
+#define DETECTOR_STATE_MAGIC 0x45505344 //"EPSD"; marks a backup slot written by this firmware
+#define DETECTOR_STATE_VERSION 5 //Bump whenever the layout of 'detector_state_t' changes
+#define MONTHS_LOG_SZ 128 //Tentative size of log of monthly rolling averages
+#define PWR_MON_REG_NUM 4 //Number of power monitor registers correlated by 'fault_correlation'
+
+
+/************** STATE DEFS **************/
+
+typedef struct {
+    uint16_t pass_num; //Main loop iteration counter regularly prompting system checks
+    uint8_t consecutive_idles; //Bitfield tracking recent MPPT idles; 0xFF means persistent idle
+    uint8_t mppt_was_reset; //Flag for recent MPPT resets by 'handle_chronic_idle'
+} chronic_idle_state_t;
+
+typedef struct {
+    float minutes_roll_avg; //rolling average of power readings over an hour
+    float hours_roll_avg; //rolling average of power readings over a day
+    float days_roll_avg; //rolling average of power readings over a month
+    float baseline_avg; //records month 1 average power; sets baseline for future monthly comparisons
+    float months_log[MONTHS_LOG_SZ]; //log of monthly rolling averages
+    uint16_t pass_num; //counter tracking iterations of the while loop
+    uint8_t minutes_pos; //counter tracking number of readings logged for minutes_roll_avg
+    uint8_t hours_pos; //counter tracking number of readings logged for hours_roll_avg
+    uint8_t days_pos; //counter tracking number of readings logged for days_roll_avg
+    uint8_t months_pos; //counter tracking the next available position for logging in months_log
+    uint8_t perform_monthly_check; //flags when a new monthly average is ready to be compared to the baseline_avg
+    uint8_t source_decay; //Global flag for occurence of 'source_decay' fault
+} source_decay_state_t;
+
+typedef struct {
+    uint64_t pass_num; //Main loop iteration counter periodically prompting device checks
+    uint32_t delay_counter; //Delay counter following a failure to read device
+    uint8_t last_test_failed; //Flag result for the last daily pwr_mon_read_error check
+    uint8_t read_error; //Flag for recent failure to read device
+} pwr_mon_read_error_state_t;
+
+typedef struct {
+    uint8_t pending; //Bitmask of queued recovery actions, one bit per 'recovery_action'
+} recovery_queue_state_t;
+
+typedef struct {
+    uint32_t clock_passes; //Main loop passes counted by 'fault_corr_tick'; wraps after roughly a year
+    uint32_t last_ok_pass[PWR_MON_REG_NUM]; //Pass of the latest successful read of each register
+    uint32_t last_fail_pass[PWR_MON_REG_NUM]; //Pass of the latest failed read of each register
+    uint32_t reads_performed; //Verification register reads put on the bus
+    uint32_t reads_saved; //Verification register reads made unnecessary by correlation
+    uint32_t follow_up_window_end; //Pass until which a cancelled follow-up is not counted as saved again
+    uint8_t ok_mask; //Registers whose latest read, by any detector, succeeded
+    uint8_t failed_mask; //Registers which failed a read since the last verification
+    uint8_t fail_seen_mask; //Registers with a failed read recorded in 'last_fail_pass'
+    uint8_t repeat_mask; //Registers whose latest failure came within the evidence window of the previous one
+    uint8_t reporter_mask; //Detectors which observed a failed read since the last verification
+    uint8_t verified_root_cause; //'fault_corr_root_cause' decided by the latest verification
+} fault_correlation_state_t;
+
+typedef struct {
+    uint32_t magic; //DETECTOR_STATE_MAGIC when the slot holds a checkpoint
+    uint16_t version; //DETECTOR_STATE_VERSION of the firmware that wrote the slot
+    uint16_t size; //sizeof(detector_state_t) of the firmware that wrote the slot
+    uint32_t sequence; //Incremented on every checkpoint; newest valid slot wins on restore
+    chronic_idle_state_t chronic_idle;
+    source_decay_state_t source_decay;
+    pwr_mon_read_error_state_t pwr_mon_read_error;
+    recovery_queue_state_t recovery_queue;
+    fault_correlation_state_t fault_correlation;
+    uint32_t checksum; //CRC-32 over every preceding byte of the struct
+} detector_state_t;
+
+extern detector_state_t g_detector_state; //Live detector state, owned field-by-field by each fault module
+
+
+/************** FUNCTION DEFS **************/
+
+/**
+  * @brief resets all detector state to its cold boot defaults
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void detector_state_reset();
+
+/**
+  * @brief restores detector state from the newest valid backup slot; falls back to cold boot defaults
+  * if no slot passes the magic, version, size and checksum checks. Call once at boot before the main loop
+  *
+  * @param None
+  *
+  * @retval 0 or -1, indicating a warm restart or a cold boot respectively
+*/
+int8_t detector_state_restore();
+
+/**
+  * @brief writes the live detector state to the older of the two backup slots
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void detector_state_commit();
+
+/**
+  * @brief counts main loop passes, committing detector state once every 'interval' passes; call once per pass
+  *
+  * @param interval number of main loop passes between commits, e.g. g_const_PASS_REQ for ~1 minute
+  *
+  * @retval None
+*/
+void detector_state_checkpoint(uint16_t interval);
+
+#endif // DETECTOR_STATE_H_
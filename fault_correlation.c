@@ -0,0 +1,199 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Source file for EPS fault detection: fault_correlation
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Merges power monitor read outcomes from every fault detector into one root-cause decision, so a single
+ * glitch does not trigger redundant verification reads of the power monitor registers.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#include "fault_correlation.h"
+#include "chronic_idle.h"
+#include "detector_state.h"
+#include "pwr_mon_read_error.h"
+#include "fault_sections.h"
+#include <stdio.h>
+#include <string.h>
+
+#define EVIDENCE_MAX_AGE (g_const_PASS_REQ*60) //Successful reads vouch for a register for ~1 hour
+
+_Static_assert(PWR_MON_REG_COUNT == PWR_MON_REG_NUM, "per-register evidence in 'detector_state.h' must cover every pwr_mon_register");
+
+static fault_correlation_state_t *const state = &g_detector_state.fault_correlation;
+static const char *const root_cause_names[] = {"none", "transient", "register", "device"};
+
+
+/**
+  * @brief checks whether a register has failed a read within the evidence window
+  *
+  * @param reg pwr_mon_register to check
+  *
+  * @retval 1 or 0, in the case of TRUE or FALSE respectively
+*/
+static uint8_t failed_recently(pwr_mon_register reg){
+
+    return (state->fail_seen_mask & (1 << reg)) && state->clock_passes - state->last_fail_pass[reg] <= EVIDENCE_MAX_AGE;
+}
+
+/**
+  * @brief advances the correlation clock; call once per main loop pass
+  *
+  * @param None
+  *
+  * @retval None
+*/
+FAULT_HOT_CODE void fault_corr_tick(){
+
+    state->clock_passes++;
+}
+
+/**
+  * @brief records the outcome of a power monitor register read made by any detector
+  *
+  * @param reg pwr_mon_register that was read
+  * @param detector fault_corr_detector which made the read
+  * @param out_message status message written by the driver
+  *
+  * @retval None
+*/
+void fault_corr_observe(pwr_mon_register reg, fault_corr_detector detector, const char *out_message){
+
+    uint8_t bit = 1 << reg;
+
+    if (strncmp(out_message, "ERROR", 5) == 0){
+
+        //A failure within the evidence window of the previous one makes the register intermittent, not transient
+        if (failed_recently(reg)){
+            state->repeat_mask |= bit;
+        } else {
+            state->repeat_mask &= ~bit;
+        }
+        state->fail_seen_mask |= bit;
+        state->last_fail_pass[reg] = state->clock_passes;
+
+        state->ok_mask &= ~bit;
+        state->failed_mask |= bit;
+        state->reporter_mask |= 1 << detector;
+
+    } else {
+
+        state->ok_mask |= bit;
+        state->last_ok_pass[reg] = state->clock_passes;
+    }
+}
+
+/**
+  * @brief decides the root cause of the read failures observed since the last verification
+  *
+  * @param None
+  *
+  * @retval fault_corr_root_cause of the power monitor
+*/
+FAULT_HOT_CODE fault_corr_root_cause fault_corr_diagnose(){
+
+    //Registers still failing, or failing repeatedly, cannot be excused by a later successful read
+    uint8_t suspect_mask = state->failed_mask & (~state->ok_mask | state->repeat_mask);
+
+    if (state->failed_mask == 0){
+        return FAULT_CORR_NONE;
+
+    } else if (suspect_mask == 0){
+        return FAULT_CORR_TRANSIENT;
+
+    } else if ((suspect_mask & (suspect_mask - 1)) == 0){
+        return FAULT_CORR_REGISTER;
+
+    } else {
+        return FAULT_CORR_DEVICE;
+    }
+}
+
+/**
+  * @brief checks whether a verification must read a register, or whether a recent successful read by any
+  * detector already vouches for it; a register which failed since the last verification or within the last
+  * hour is always read. Skipped reads are counted as saved bus transactions
+  *
+  * @param reg pwr_mon_register to be verified
+  *
+  * @retval 1 or 0, in the case of TRUE or FALSE respectively
+*/
+uint8_t fault_corr_needs_read(pwr_mon_register reg){
+
+    uint8_t bit = 1 << reg;
+
+    if ((state->ok_mask & bit) && !(state->failed_mask & bit) && !failed_recently(reg)
+            && state->clock_passes - state->last_ok_pass[reg] <= EVIDENCE_MAX_AGE){
+
+        state->reads_saved++;
+        return FALSE;
+    }
+
+    state->reads_performed++;
+    return TRUE;
+}
+
+/**
+  * @brief closes the current evidence window once a verification has completed
+  *
+  * @param root_cause fault_corr_root_cause diagnosed once every required register had been read
+  *
+  * @retval None
+*/
+void fault_corr_verified(fault_corr_root_cause root_cause){
+
+    state->verified_root_cause = root_cause;
+    state->failed_mask = 0;
+    state->reporter_mask = 0;
+}
+
+/**
+  * @brief counts a follow-up read cancelled as transient as saved bus transactions, at most once per follow-up
+  * delay, as the delayed follow-up it replaces would have covered every read error within its delay; the
+  * evidence window stays open, so the next verification still reads every register which failed
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void fault_corr_cancel_follow_up(){
+
+    //Signed difference keeps the comparison correct across clock wraparound
+    if ((int32_t)(state->clock_passes - state->follow_up_window_end) >= 0){
+
+        state->reads_saved += PWR_MON_REG_COUNT;
+        state->follow_up_window_end = state->clock_passes + READ_ERROR_DELAY;
+    }
+}
+
+/**
+  * @brief counts a whole verification made unnecessary by correlation as saved bus transactions; does not
+  * close the evidence window
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void fault_corr_skip_verification(){
+
+    state->reads_saved += PWR_MON_REG_COUNT;
+}
+
+/**
+  * @brief prints verification bus transactions performed and saved, with the last verified and current
+  * root-cause decisions
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void fault_corr_print_report(){
+
+    printf("Fault correlation: %lu verification reads performed, %lu saved, last verified root cause: %s, "
+            "current: %s (reported by mask 0x%02X)\n",
+            (unsigned long)state->reads_performed, (unsigned long)state->reads_saved,
+            root_cause_names[state->verified_root_cause], root_cause_names[fault_corr_diagnose()],
+            state->reporter_mask);
+}
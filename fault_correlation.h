@@ -0,0 +1,122 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Header file for EPS fault detection: fault_correlation
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Merges power monitor read outcomes from every fault detector into one root-cause decision, so a single
+ * glitch does not trigger redundant verification reads of the power monitor registers.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#ifndef FAULT_CORRELATION_H_
+#define FAULT_CORRELATION_H_
+
+#include <stdint.h>
+
+typedef enum {
+    PWR_MON_REG_TEMP = 0,
+    PWR_MON_REG_V_BUS = 1,
+    PWR_MON_REG_CURRENT = 2,
+    PWR_MON_REG_POWER = 3,
+    PWR_MON_REG_COUNT = 4 //Must match PWR_MON_REG_NUM in 'detector_state.h'; checked in 'fault_correlation.c'
+} pwr_mon_register;
+
+typedef enum {
+    FAULT_CORR_CHRONIC_IDLE = 0,
+    FAULT_CORR_SOURCE_DECAY = 1,
+    FAULT_CORR_PWR_MON_READ_ERROR = 2
+} fault_corr_detector;
+
+typedef enum {
+    FAULT_CORR_NONE = 0, //No read failures since the last verification
+    FAULT_CORR_TRANSIENT = 1, //Every register that failed did so in isolation and has since been read successfully
+    FAULT_CORR_REGISTER = 2, //Failures persist or recur on a single register
+    FAULT_CORR_DEVICE = 3 //Failures persist or recur on several registers; the device itself is suspect
+} fault_corr_root_cause;
+
+
+/************** FUNCTION DEFS **************/
+
+/**
+  * @brief advances the correlation clock; call once per main loop pass
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void fault_corr_tick();
+
+/**
+  * @brief records the outcome of a power monitor register read made by any detector
+  *
+  * @param reg pwr_mon_register that was read
+  * @param detector fault_corr_detector which made the read
+  * @param out_message status message written by the driver
+  *
+  * @retval None
+*/
+void fault_corr_observe(pwr_mon_register reg, fault_corr_detector detector, const char *out_message);
+
+/**
+  * @brief decides the root cause of the read failures observed since the last verification
+  *
+  * @param None
+  *
+  * @retval fault_corr_root_cause of the power monitor
+*/
+fault_corr_root_cause fault_corr_diagnose();
+
+/**
+  * @brief checks whether a verification must read a register, or whether a recent successful read by any
+  * detector already vouches for it; a register which failed since the last verification or within the last
+  * hour is always read. Skipped reads are counted as saved bus transactions
+  *
+  * @param reg pwr_mon_register to be verified
+  *
+  * @retval 1 or 0, in the case of TRUE or FALSE respectively
+*/
+uint8_t fault_corr_needs_read(pwr_mon_register reg);
+
+/**
+  * @brief closes the current evidence window once a verification has completed
+  *
+  * @param root_cause fault_corr_root_cause diagnosed once every required register had been read
+  *
+  * @retval None
+*/
+void fault_corr_verified(fault_corr_root_cause root_cause);
+
+/**
+  * @brief counts a follow-up read cancelled as transient as saved bus transactions, at most once per follow-up
+  * delay, as the delayed follow-up it replaces would have covered every read error within its delay; the
+  * evidence window stays open, so the next verification still reads every register which failed
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void fault_corr_cancel_follow_up();
+
+/**
+  * @brief counts a whole verification made unnecessary by correlation as saved bus transactions; does not
+  * close the evidence window
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void fault_corr_skip_verification();
+
+/**
+  * @brief prints verification bus transactions performed and saved, with the last verified and current
+  * root-cause decisions
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void fault_corr_print_report();
+
+#endif // FAULT_CORRELATION_H_
@@ -0,0 +1,40 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Source file for EPS fault detection: fault_sections
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Loads the FAULT_HOT_RAM state and constants into CCM, which the stock startup code leaves uninitialized.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#include "fault_sections.h"
+#include <stdint.h>
+
+#ifdef FAULT_HOT_RAM
+
+//Defined by the CubeIDE linker script around the '.ccmram' output section ('*(.ccmram*)' AT> FLASH)
+extern uint32_t _siccmram; //Load address of the section in flash
+extern uint32_t _sccmram; //Start of the section in CCM
+extern uint32_t _eccmram; //End of the section in CCM
+
+
+/**
+  * @brief copies the '.ccmram' load image from flash into CCM; call first thing in main(), before any
+  * FAULT_HOT_RAM code, state or constant in CCM is used
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void fault_hot_ram_init(){
+
+    const uint32_t *src = &_siccmram;
+
+    for (uint32_t *dst = &_sccmram; dst < &_eccmram; dst++){
+        *dst = *src++;
+    }
+}
+
+#endif // FAULT_HOT_RAM
@@ -0,0 +1,60 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Header file for EPS fault detection: fault_sections
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Opt-in placement of the per-pass detector code and state in fast RAM (build with FAULT_HOT_RAM).
+ * Code defaults to '.RamFunc', which the CubeIDE linker scripts place in SRAM and the stock startup code copies
+ * from flash; this runs on every part, including the F4, which cannot execute from CCM. State and constants
+ * default to the CubeIDE '.ccmram' output section, which the stock startup code does not load: call
+ * 'fault_hot_ram_init' first thing in main(). F3/G4 parts may also run the code from CCM by setting
+ * FAULT_HOT_CODE_SECTION to ".ccmram_text". Sections overridden for other memories, e.g. ITCM/DTCM on the
+ * F7/H7, must be loaded by the startup code instead. Long branches between RAM and flash are bridged by linker veneers.
+ * Run 'footprint_check.py' to verify the layout, the per-module budgets and the worst-case stack depth.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#ifndef FAULT_SECTIONS_H_
+#define FAULT_SECTIONS_H_
+
+#ifdef FAULT_HOT_RAM
+
+#ifndef FAULT_HOT_CODE_SECTION
+#define FAULT_HOT_CODE_SECTION ".RamFunc" //Executed every main loop pass
+#endif
+#ifndef FAULT_HOT_DATA_SECTION
+#define FAULT_HOT_DATA_SECTION ".ccmram_data" //Read and written every main loop pass
+#endif
+#ifndef FAULT_HOT_RODATA_SECTION
+#define FAULT_HOT_RODATA_SECTION ".ccmram_rodata" //Constants read every main loop pass
+#endif
+
+#define FAULT_HOT_CODE __attribute__((section(FAULT_HOT_CODE_SECTION)))
+#define FAULT_HOT_DATA __attribute__((section(FAULT_HOT_DATA_SECTION)))
+#define FAULT_HOT_RODATA __attribute__((section(FAULT_HOT_RODATA_SECTION)))
+
+
+/************** FUNCTION DEFS **************/
+
+/**
+  * @brief copies the '.ccmram' load image from flash into CCM; call first thing in main(), before any
+  * FAULT_HOT_RAM code, state or constant in CCM is used
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void fault_hot_ram_init();
+
+#else
+
+#define FAULT_HOT_CODE
+#define FAULT_HOT_DATA
+#define FAULT_HOT_RODATA
+#define fault_hot_ram_init() ((void)0)
+
+#endif // FAULT_HOT_RAM
+
+#endif // FAULT_SECTIONS_H_
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+#
+# Date Created: 18/10/26
+# Last Modified: 18/10/26
+#
+# Host-side footprint check for the EPS fault detection firmware.
+# Reports flash, RAM and worst-case stack per module and fails when a module exceeds its budget.
+# With --hot, also verifies that the per-pass code, state and constants landed in the FAULT_HOT_RAM
+# sections (see 'fault_sections.h').
+#
+# Build each module into one directory with call graph and stack info (GCC 10 or later), e.g.
+#   arm-none-eabi-gcc -c -O2 -mcpu=cortex-m4 -mthumb -fcallgraph-info=su [-DFAULT_HOT_RAM] \
+#       chronic_idle.c -o build/chronic_idle.o
+# then run
+#   python3 footprint_check.py [--hot] build
+# Overridden FAULT_HOT_*_SECTION names must be exported to the environment under the same names.
+#
+# Author(s): Winston Fournier
+#
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# Budgets in bytes per module: (flash, ram, worst-case stack from any function in the module)
+# Sized for the build above at -O2 with READ_TRACE_ENABLE and POWER_BLOCK_SAMPLING; -O3 inlines and unrolls past them
+# RAM includes FAULT_HOT_RAM code and constants, which occupy RAM as well as their flash load image
+BUDGETS = {
+    "chronic_idle":       (1024,   256,  384),
+    "source_decay":       (1536,   320,  384),
+    "pwr_mon_read_error": (1536,   448,  384),
+    "detector_state":     (2048,  2560,  256),
+    "read_trace":         (1280, 13824,  320),
+    "recovery_queue":     (512,    256,  384),
+    "fault_correlation":  (1024,   192,  256),
+    "power_block":        (1024,   384,  256),
+}
+
+# Worst-case stack of one main loop pass; the pass entry points run one after another
+PASS_ENTRIES = ["detect_chronic_idle", "detect_source_decay", "detect_pwr_mon_read_error",
+                "recovery_drain", "detector_state_checkpoint"]
+PASS_STACK_BUDGET = 512
+
+# Symbols which FAULT_HOT_RAM must place in core-coupled RAM: section macro -> symbols
+HOT_SYMBOLS = {
+    "FAULT_HOT_CODE": ["detect_chronic_idle", "convert_raw_to_celsius", "convert_raw_to_mv",
+                       "detect_source_decay", "convert_raw_to_watts", "CURRENT_LSB",
+                       "detect_pwr_mon_read_error", "follow_up_read", "daily_read",
+                       "fault_corr_tick", "fault_corr_diagnose", "recovery_drain", "detector_state_checkpoint"],
+    "FAULT_HOT_DATA": ["g_detector_state", "checkpoint_pass_num"],
+    "FAULT_HOT_RODATA": ["g_const_PASS_REQ", "TEMP_CONVERT_FAC", "VOLT_CONVERT_FAC"],
+}
+HOT_SECTION_DEFAULTS = {
+    "FAULT_HOT_CODE": ".RamFunc",
+    "FAULT_HOT_DATA": ".ccmram_data",
+    "FAULT_HOT_RODATA": ".ccmram_rodata",
+}
+
+FLASH_PREFIXES = (".text", ".rodata", ".data")  # .data counts once in flash for its load image
+RAM_PREFIXES = (".data", ".bss", ".bkpsram")
+
+
+def run(command):
+    """Runs a binutils command and returns its output."""
+    return subprocess.run(command, check=True, capture_output=True, text=True).stdout
+
+
+def section_sizes(prefix, obj):
+    """Returns {section name: size} for the allocatable sections of an object."""
+    sizes = {}
+    for line in run([prefix + "size", "-A", obj]).splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[0].startswith(".") and fields[1].isdigit():
+            sizes[fields[0]] = int(fields[1])
+    return sizes
+
+
+def symbol_sections(prefix, obj):
+    """Returns {symbol name: section name} for the functions and objects defined in an object."""
+    symbols = {}
+    for line in run([prefix + "objdump", "-t", obj]).splitlines():
+        if "\t" not in line:
+            continue
+        left, right = line.split("\t", 1)
+        left_fields = left.split()
+        right_fields = right.split()
+        if len(left_fields) < 3 or len(right_fields) < 2 or left_fields[-1] in ("*UND*", "*ABS*"):
+            continue
+        if "F" in left_fields[1:-1] or "O" in left_fields[1:-1]:
+            symbols[right_fields[-1]] = left_fields[-1]
+    return symbols
+
+
+def parse_callgraph(paths):
+    """Merges GCC .ci call graphs into ({function: (frame bytes, qualifier)}, {function: set of callees})."""
+    frames = {}
+    calls = {}
+    node_re = re.compile(r'node: \{ title: "([^"]+)" label: "[^"]*?\\n(\d+) bytes \(([a-z,]+)\)')
+    edge_re = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+    for path in paths:
+        with open(path) as f:
+            for line in f:
+                node = node_re.search(line)
+                if node:
+                    frames[node.group(1)] = (int(node.group(2)), node.group(3))
+                edge = edge_re.search(line)
+                if edge:
+                    calls.setdefault(edge.group(1), set()).add(edge.group(2))
+    return frames, calls
+
+
+def worst_stack(function, frames, calls, extern_stack, memo, active, problems):
+    """Returns the deepest stack reachable from a function, noting recursion and unbounded frames."""
+    if function in memo:
+        return memo[function]
+    if function in active:
+        problems.add("recursion through " + function)
+        return 0
+    if function not in frames:
+        # Drivers, libc and indirect calls: no frame information, so assume the allowance
+        return extern_stack
+    frame, qualifier = frames[function]
+    if qualifier == "dynamic":
+        problems.add("unbounded dynamic stack in " + function)
+    active.add(function)
+    deepest = max([worst_stack(callee, frames, calls, extern_stack, memo, active, problems)
+                   for callee in calls.get(function, ())] or [0])
+    active.discard(function)
+    memo[function] = frame + deepest
+    return memo[function]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per-module flash/RAM/stack budgets and hot section layout")
+    parser.add_argument("objdir", help="directory holding <module>.o and .ci files")
+    parser.add_argument("--prefix", default="arm-none-eabi-", help="binutils prefix, '' for host tools")
+    parser.add_argument("--hot", action="store_true", help="objects were built with FAULT_HOT_RAM")
+    parser.add_argument("--extern-stack", type=int, default=128,
+                        help="stack assumed for calls without frame information (drivers, libc)")
+    args = parser.parse_args()
+
+    hot_sections = {macro: os.environ.get(macro + "_SECTION", default)
+                    for macro, default in HOT_SECTION_DEFAULTS.items()}
+    failures = []
+
+    ci_paths = [os.path.join(args.objdir, m + ".ci") for m in BUDGETS
+                if os.path.exists(os.path.join(args.objdir, m + ".ci"))]
+    frames, calls = parse_callgraph(ci_paths)
+    memo = {}
+    problems = set()
+
+    print("%-20s %8s %8s %8s" % ("module", "flash", "ram", "stack"))
+    all_symbols = {}
+    for module, (flash_budget, ram_budget, stack_budget) in BUDGETS.items():
+        obj = os.path.join(args.objdir, module + ".o")
+        if not os.path.exists(obj):
+            failures.append("%s: missing %s" % (module, obj))
+            continue
+
+        flash = 0
+        ram = 0
+        for name, size in section_sizes(args.prefix, obj).items():
+            hot = name in hot_sections.values()
+            if name.startswith(FLASH_PREFIXES) or hot:
+                flash += size
+            if name.startswith(RAM_PREFIXES) or hot:
+                ram += size
+
+        symbols = symbol_sections(args.prefix, obj)
+        all_symbols.update(symbols)
+        stack = max([worst_stack(fn, frames, calls, args.extern_stack, memo, set(), problems)
+                     for fn in symbols if fn in frames] or [0])
+
+        print("%-20s %8d %8d %8d" % (module, flash, ram, stack))
+        for label, used, budget in (("flash", flash, flash_budget), ("ram", ram, ram_budget),
+                                    ("stack", stack, stack_budget)):
+            if used > budget:
+                failures.append("%s: %s %d exceeds budget %d" % (module, label, used, budget))
+
+    pass_stack = max(worst_stack(fn, frames, calls, args.extern_stack, memo, set(), problems)
+                     for fn in PASS_ENTRIES)
+    print("%-20s %26d" % ("main loop pass", pass_stack))
+    if pass_stack > PASS_STACK_BUDGET:
+        failures.append("main loop pass: stack %d exceeds budget %d" % (pass_stack, PASS_STACK_BUDGET))
+    failures.extend(sorted(problems))
+
+    if args.hot:
+        for macro, names in HOT_SYMBOLS.items():
+            for name in names:
+                section = all_symbols.get(name)
+                if section != hot_sections[macro]:
+                    failures.append("layout: %s is in %s, expected %s" % (name, section, hot_sections[macro]))
+
+    for failure in failures:
+        print("FAIL " + failure)
+    print("footprint check " + ("failed" if failures else "passed"))
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
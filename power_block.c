@@ -0,0 +1,164 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Source file for EPS fault detection: power_block
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Reduces a burst of raw power samples to one robust value (trimmed mean) so a single glitch
+ * cannot skew the source_decay rolling averages.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#include "power_block.h"
+
+#ifdef USE_HAL_DRIVER
+#include "main.h"
+#elif defined(__SSE4_1__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+//The vectorized paths only pay for their setup and horizontal folds on blocks of at least POWER_BLOCK_SIMD_MIN
+#if POWER_BLOCK_SZ >= POWER_BLOCK_SIMD_MIN
+#define POWER_BLOCK_SIMD
+#endif
+
+//Keeps the scalar reference scalar; GCC auto-vectorizes its loop otherwise (at -O2 from GCC 12)
+#if defined(__GNUC__) && !defined(__clang__)
+#define NO_AUTO_VECTORIZE __attribute__((optimize("no-tree-vectorize")))
+#else
+#define NO_AUTO_VECTORIZE
+#endif
+
+
+/**
+  * @brief folds the block extremes and sum into a trimmed mean, rounded to nearest
+  *
+  * @param sum sum of all samples
+  * @param min lowest sample
+  * @param max highest sample
+  * @param count number of samples
+  *
+  * @retval trimmed mean of the samples
+*/
+static uint16_t trimmed_mean(uint32_t sum, uint16_t min, uint16_t max, uint16_t count){
+
+    uint32_t kept = count - 2;
+
+    return (uint16_t)((sum - min - max + kept / 2) / kept);
+}
+
+/**
+  * @brief portable reference for 'power_block_reduce', used for verification and benchmarking
+  *
+  * @param samples raw power register values (16 bits wide as per data sheet)
+  * @param count number of samples, at least 3
+  *
+  * @retval trimmed mean of the samples in raw power register units
+*/
+NO_AUTO_VECTORIZE uint16_t power_block_reduce_scalar(const uint16_t *samples, uint16_t count){
+
+    uint32_t sum = 0;
+    uint16_t min = 0xFFFF;
+    uint16_t max = 0;
+
+    for (uint16_t i = 0; i < count; i++){
+
+        sum += samples[i];
+        min = samples[i] < min ? samples[i] : min;
+        max = samples[i] > max ? samples[i] : max;
+    }
+
+    return trimmed_mean(sum, min, max, count);
+}
+
+/**
+  * @brief reduces a block of raw power samples to their trimmed mean, discarding the lowest and highest sample;
+  * uses Cortex-M4 DSP instructions on target and SSE4.1/AVX2 on host where available and POWER_BLOCK_SZ is at
+  * least POWER_BLOCK_SIMD_MIN
+  *
+  * @param samples raw power register values (16 bits wide as per data sheet)
+  * @param count number of samples, at least 3
+  *
+  * @retval trimmed mean of the samples in raw power register units
+*/
+uint16_t power_block_reduce(const uint16_t *samples, uint16_t count){
+
+    uint32_t sum = 0;
+    uint16_t min = 0xFFFF;
+    uint16_t max = 0;
+    uint16_t i = 0;
+
+#if defined(POWER_BLOCK_SIMD) && defined(USE_HAL_DRIVER) && defined(__ARM_FEATURE_DSP)
+    //Two samples per word: USUB16 sets the GE flag of each halfword lane, SEL then picks per lane
+    uint32_t pair_min = 0xFFFFFFFF;
+    uint32_t pair_max = 0;
+
+    for (; i + 2 <= count; i += 2){
+
+        uint32_t pair = __UNALIGNED_UINT32_READ(&samples[i]);
+
+        __USUB16(pair, pair_max);
+        pair_max = __SEL(pair, pair_max);
+        __USUB16(pair, pair_min);
+        pair_min = __SEL(pair_min, pair);
+        sum += (pair & 0xFFFF) + (pair >> 16);
+    }
+
+    min = (pair_min & 0xFFFF) < (pair_min >> 16) ? (pair_min & 0xFFFF) : (pair_min >> 16);
+    max = (pair_max & 0xFFFF) > (pair_max >> 16) ? (pair_max & 0xFFFF) : (pair_max >> 16);
+
+#elif defined(POWER_BLOCK_SIMD) && defined(__SSE4_1__)
+    __m128i vec_min = _mm_set1_epi16(-1);
+    __m128i vec_max = _mm_setzero_si128();
+    __m128i vec_sum = _mm_setzero_si128();
+    const __m128i zero = _mm_setzero_si128();
+
+#ifdef __AVX2__
+    //Sixteen samples per step, folded into the 128-bit accumulators
+    __m256i wide_min = _mm256_set1_epi16(-1);
+    __m256i wide_max = _mm256_setzero_si256();
+    __m256i wide_sum = _mm256_setzero_si256();
+
+    for (; i + 16 <= count; i += 16){
+
+        __m256i v = _mm256_loadu_si256((const __m256i *)&samples[i]);
+
+        wide_min = _mm256_min_epu16(wide_min, v);
+        wide_max = _mm256_max_epu16(wide_max, v);
+        wide_sum = _mm256_add_epi32(wide_sum, _mm256_unpacklo_epi16(v, _mm256_setzero_si256()));
+        wide_sum = _mm256_add_epi32(wide_sum, _mm256_unpackhi_epi16(v, _mm256_setzero_si256()));
+    }
+
+    vec_min = _mm_min_epu16(_mm256_castsi256_si128(wide_min), _mm256_extracti128_si256(wide_min, 1));
+    vec_max = _mm_max_epu16(_mm256_castsi256_si128(wide_max), _mm256_extracti128_si256(wide_max, 1));
+    vec_sum = _mm_add_epi32(_mm256_castsi256_si128(wide_sum), _mm256_extracti128_si256(wide_sum, 1));
+#endif
+
+    for (; i + 8 <= count; i += 8){
+
+        __m128i v = _mm_loadu_si128((const __m128i *)&samples[i]);
+
+        vec_min = _mm_min_epu16(vec_min, v);
+        vec_max = _mm_max_epu16(vec_max, v);
+        vec_sum = _mm_add_epi32(vec_sum, _mm_unpacklo_epi16(v, zero));
+        vec_sum = _mm_add_epi32(vec_sum, _mm_unpackhi_epi16(v, zero));
+    }
+
+    //PHMINPOSUW finds the lowest lane; the highest is the lowest of the complement
+    min = (uint16_t)_mm_cvtsi128_si32(_mm_minpos_epu16(vec_min));
+    max = (uint16_t)~_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(vec_max, _mm_set1_epi16(-1))));
+    vec_sum = _mm_add_epi32(vec_sum, _mm_shuffle_epi32(vec_sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    vec_sum = _mm_add_epi32(vec_sum, _mm_shuffle_epi32(vec_sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = (uint32_t)_mm_cvtsi128_si32(vec_sum);
+#endif
+
+    for (; i < count; i++){
+
+        sum += samples[i];
+        min = samples[i] < min ? samples[i] : min;
+        max = samples[i] > max ? samples[i] : max;
+    }
+
+    return trimmed_mean(sum, min, max, count);
+}
@@ -0,0 +1,67 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Header file for EPS fault detection: power_block
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Reduces a burst of raw power samples to one robust value (trimmed mean) so a single glitch
+ * cannot skew the source_decay rolling averages.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#ifndef POWER_BLOCK_H_
+#define POWER_BLOCK_H_
+
+#include <stdint.h>
+
+#ifndef POWER_BLOCK_SZ
+#define POWER_BLOCK_SZ 16 //Tentative number of power samples per burst; must be at least 3
+#endif
+#if POWER_BLOCK_SZ < 3
+#error "POWER_BLOCK_SZ must be at least 3: the trimmed mean discards the lowest and highest sample"
+#endif
+
+#ifndef POWER_BLOCK_SIMD_MIN
+#ifdef USE_HAL_DRIVER
+#define POWER_BLOCK_SIMD_MIN 4 //Smallest block reduced with Cortex-M4 DSP pairs; two pairs cover the halfword folds
+#else
+#define POWER_BLOCK_SIMD_MIN 8 //Smallest block reduced with SSE4.1/AVX2; below one 128-bit vector the scalar loop wins
+#endif
+#endif
+
+
+/************** FUNCTION DEFS **************/
+
+/**
+  * @brief reduces a block of raw power samples to their trimmed mean, discarding the lowest and highest sample;
+  * uses Cortex-M4 DSP instructions on target and SSE4.1/AVX2 on host where available
+  *
+  * @param samples raw power register values (16 bits wide as per data sheet)
+  * @param count number of samples, at least 3
+  *
+  * @retval trimmed mean of the samples in raw power register units
+*/
+uint16_t power_block_reduce(const uint16_t *samples, uint16_t count);
+
+/**
+  * @brief portable reference for 'power_block_reduce', used for verification and benchmarking
+  *
+  * @param samples raw power register values (16 bits wide as per data sheet)
+  * @param count number of samples, at least 3
+  *
+  * @retval trimmed mean of the samples in raw power register units
+*/
+uint16_t power_block_reduce_scalar(const uint16_t *samples, uint16_t count);
+
+/**
+  * @brief measures average cycles per block for the vectorized and scalar reductions and prints both;
+  * defined in 'power_block_bench.c', which is linked into benchmark builds only
+  *
+  * @param iterations number of blocks reduced by each path, at least 1
+  *
+  * @retval None
+*/
+void power_block_benchmark(uint32_t iterations);
+
+#endif // POWER_BLOCK_H_
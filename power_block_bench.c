@@ -0,0 +1,139 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Source file for EPS fault diagnostics: power_block_bench
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Compares cycles per block of the vectorized and scalar 'power_block' reductions. On host, build and run e.g.
+ * gcc -O2 -mavx2 -o power_block_bench power_block_bench.c power_block.c
+ * On target, link this file into a benchmark build and call 'power_block_benchmark' to measure with the
+ * DWT cycle counter; flight builds leave it out.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#include "power_block.h"
+#include <stdio.h>
+
+#ifdef USE_HAL_DRIVER
+#include "main.h"
+typedef uint32_t bench_cycles_t; //DWT->CYCCNT is 32 bits; differences stay correct across one wrap
+#else
+#include <stdlib.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+typedef uint64_t bench_cycles_t;
+#endif
+
+#define BENCH_BLOCKS 8 //Distinct sample blocks cycled through by 'power_block_benchmark'
+
+static uint16_t blocks[BENCH_BLOCKS][POWER_BLOCK_SZ]; //Benchmark input, regenerated on every run
+
+
+/**
+  * @brief reads a free-running cycle counter (DWT on target, TSC on x86 hosts, nanoseconds elsewhere)
+  *
+  * @param None
+  *
+  * @retval current counter value
+*/
+static bench_cycles_t read_cycles(){
+
+#ifdef USE_HAL_DRIVER
+    return DWT->CYCCNT;
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+}
+
+/**
+  * @brief measures average cycles per block for the vectorized and scalar reductions and prints both
+  *
+  * @param iterations number of blocks reduced by each path, at least 1
+  *
+  * @retval None
+*/
+void power_block_benchmark(uint32_t iterations){
+
+    uint32_t seed = 12345;
+    volatile uint16_t sink = 0;
+    uint32_t mismatches = 0;
+
+    if (iterations == 0){
+        return;
+    }
+
+#ifdef USE_HAL_DRIVER
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    //Noisy readings around a plausible level with one glitch per block
+    for (uint16_t b = 0; b < BENCH_BLOCKS; b++){
+
+        for (uint16_t i = 0; i < POWER_BLOCK_SZ; i++){
+            seed = seed * 1664525 + 1013904223;
+            blocks[b][i] = 20000 + (seed >> 22);
+        }
+        blocks[b][seed % POWER_BLOCK_SZ] = 0xFFFF;
+
+        if (power_block_reduce(blocks[b], POWER_BLOCK_SZ) != power_block_reduce_scalar(blocks[b], POWER_BLOCK_SZ)){
+            mismatches++;
+        }
+    }
+
+    bench_cycles_t start = read_cycles();
+    for (uint32_t n = 0; n < iterations; n++){
+        sink = power_block_reduce(blocks[n % BENCH_BLOCKS], POWER_BLOCK_SZ);
+    }
+    bench_cycles_t vector_cycles = read_cycles() - start;
+
+    start = read_cycles();
+    for (uint32_t n = 0; n < iterations; n++){
+        sink = power_block_reduce_scalar(blocks[n % BENCH_BLOCKS], POWER_BLOCK_SZ);
+    }
+    bench_cycles_t scalar_cycles = read_cycles() - start;
+
+    (void)sink;
+    printf("power_block: %u samples/block, %lu cycles/block vectorized, %lu cycles/block scalar, %lu mismatches\n",
+            (unsigned)POWER_BLOCK_SZ, (unsigned long)(vector_cycles / iterations),
+            (unsigned long)(scalar_cycles / iterations), (unsigned long)mismatches);
+}
+
+#ifndef USE_HAL_DRIVER
+/**
+  * @brief runs the power_block benchmark on host
+  *
+  * @param argc argument count
+  * @param argv optional number of blocks reduced by each path, a positive integer
+  *
+  * @retval 0 or 1, indicating a completed run or an invalid argument respectively
+*/
+int main(int argc, char **argv){
+
+    uint32_t iterations = 10000000;
+
+    if (argc > 1){
+
+        char *end;
+        unsigned long parsed = strtoul(argv[1], &end, 10);
+
+        if (end == argv[1] || *end != '\0' || parsed == 0 || parsed > UINT32_MAX){
+            printf("Usage: %s [iterations > 0]\n", argv[0]);
+            return 1;
+        }
+        iterations = (uint32_t)parsed;
+    }
+
+    power_block_benchmark(iterations);
+    return 0;
+}
+#endif // USE_HAL_DRIVER
@@ -1,6 +1,6 @@
 /*
  * Date Created: 07/09/24
- * Last Modified: 14/09/24
+ * Last Modified: 18/10/26
  *
  * Source file for EPS fault detection: pwr_mon_read_error
  * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
@@ -12,14 +12,16 @@
 #include "pwr_mon_read_error.h"
 #include "chronic_idle.h"
 #include "load_switches.h"
+#include "detector_state.h"
+#include "read_trace.h"
+#include "recovery_queue.h"
+#include "fault_correlation.h"
+#include "fault_sections.h"
 #include <string.h>
 
-static uint64_t pass_num = 0; //Main loop iteration counter periodically prompting device checks
-static uint32_t delay_counter = 0; //Delay counter following a failure to read device
-static uint8_t last_test_failed = FALSE; //Flag result for the last daily pwr_mon_read_error check
-static const uint32_t read_error_delay = g_const_PASS_REQ*60; //Software loop based delay equivalent to ~1 hour
+static pwr_mon_read_error_state_t *const state = &g_detector_state.pwr_mon_read_error; //Persistent counters and flags, see 'detector_state.h'
+
 static const uint16_t read_error_pass_constant = 60*24; //Minutes per day
-uint8_t g_read_error = 0; //Flag for recent failure to read device
 
 /**
   * @brief attempts to check power monitor's detected temperature
@@ -31,7 +33,9 @@ uint8_t g_read_error = 0; //Flag for recent failure to read device
 int8_t temp_check(){
     
     char out_message[50];
-    eps_get_power_monitor_temp_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    int16_t raw_temp_val = eps_get_power_monitor_temp_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    read_trace_record(READ_TRACE_SRC_TEMP, raw_temp_val, out_message);
+    fault_corr_observe(PWR_MON_REG_TEMP, FAULT_CORR_PWR_MON_READ_ERROR, out_message);
 
     if (strcmp(out_message, "ERRORT\r\n") == 0){
         
@@ -51,7 +55,9 @@ int8_t temp_check(){
 int8_t volt_check(){
 
     char out_message[50];
-    eps_get_power_monitor_v_bus_val_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    int16_t raw_volt_val = eps_get_power_monitor_v_bus_val_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    read_trace_record(READ_TRACE_SRC_V_BUS, raw_volt_val, out_message);
+    fault_corr_observe(PWR_MON_REG_V_BUS, FAULT_CORR_PWR_MON_READ_ERROR, out_message);
 
     if (strcmp(out_message, "ERRORV\r\n") == 0){
         
@@ -71,7 +77,9 @@ int8_t volt_check(){
 int8_t current_check(){
 
     char out_message[50];
-    eps_get_power_monitor_current_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    int16_t raw_current_val = eps_get_power_monitor_current_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    read_trace_record(READ_TRACE_SRC_CURRENT, raw_current_val, out_message);
+    fault_corr_observe(PWR_MON_REG_CURRENT, FAULT_CORR_PWR_MON_READ_ERROR, out_message);
 
     if (strcmp(out_message, "ERRORC\r\n") == 0){
         
@@ -91,7 +99,9 @@ int8_t current_check(){
 int8_t power_check(){
 
     char out_message[50];
-    eps_get_power_monitor_power_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    int32_t raw_power_val = eps_get_power_monitor_power_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    read_trace_record(READ_TRACE_SRC_POWER, raw_power_val, out_message);
+    fault_corr_observe(PWR_MON_REG_POWER, FAULT_CORR_PWR_MON_READ_ERROR, out_message);
 
     if (strcmp(out_message, "ERRORP\r\n") == 0){
         
@@ -102,33 +112,97 @@ int8_t power_check(){
 }
 
 /**
-  * @brief if power monitor has previously failed to check a register, attemps to check registers again after a delay
+  * @brief attempts to check every power monitor register, skipping registers another detector has
+  * recently read successfully, then records the root cause of any failures
   *
   * @param None
   *
   * @retval 0 or -1, reflecting whether or not the operation has succeeded
 */
-int8_t follow_up_read(){
+int8_t verify_pwr_mon_registers(){
+
+    int8_t result = 0;
+
+    //Every required register is read even after a failure, so a dead device fails on all of them
+    if (fault_corr_needs_read(PWR_MON_REG_TEMP) && temp_check() == ERROR){
+        result = ERROR;
+    }
+    if (fault_corr_needs_read(PWR_MON_REG_V_BUS) && volt_check() == ERROR){
+        result = ERROR;
+    }
+    if (fault_corr_needs_read(PWR_MON_REG_CURRENT) && current_check() == ERROR){
+        result = ERROR;
+    }
+    if (fault_corr_needs_read(PWR_MON_REG_POWER) && power_check() == ERROR){
+        result = ERROR;
+    }
+
+    fault_corr_verified(fault_corr_diagnose());
+    return result;
+}
+
+/**
+  * @brief if power monitor has previously failed to check a register, queues a re-read of the registers after a delay;
+  * the re-read itself runs from 'recovery_drain' via 'run_follow_up_read'
+  *
+  * @param None
+  *
+  * @retval None
+*/
+FAULT_HOT_CODE void follow_up_read(){
+
+    //Repeated failures seen by any detector need a follow-up even if no detector lost a whole reading to them
+    if (g_read_error == 0 && !recovery_is_pending(RECOVERY_PWR_MON_REREAD)
+            && fault_corr_diagnose() >= FAULT_CORR_REGISTER){
+        g_read_error = 1;
+    }
 
     if (g_read_error == 1){
-        
-        if (delay_counter >= read_error_delay){
 
-            delay_counter = 0;
+        //Every failed register failed in isolation and has since been read successfully; nothing left to verify
+        if (fault_corr_diagnose() == FAULT_CORR_TRANSIENT){
+
+            state->delay_counter = 0;
             g_read_error = 0;
+            fault_corr_cancel_follow_up();
 
-            if (temp_check() == ERROR || volt_check() == ERROR || current_check() == ERROR || power_check() == ERROR){
+        } else if (state->delay_counter >= READ_ERROR_DELAY){
 
-                return ERROR;
-            }
+            state->delay_counter = 0;
+            g_read_error = 0;
+
+            recovery_post(RECOVERY_PWR_MON_REREAD);
 
         } else{
 
-            delay_counter++;
+            state->delay_counter++;
         }   
     }
+}
 
-    return 0;
+/**
+  * @brief runs the queued follow-up read; a passing follow-up also serves as a daily check held back for it
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void run_follow_up_read(){
+
+    if (verify_pwr_mon_registers() == ERROR){
+
+        handle_pwr_mon_read_error();
+
+    } else {
+
+        //Daily check held back for this follow-up is satisfied by it
+        if (state->pass_num >= g_const_PASS_REQ * read_error_pass_constant){
+
+            fault_corr_skip_verification();
+            state->pass_num = 0;
+            state->last_test_failed = FALSE;
+        }
+    }
 }
 
 /**
@@ -138,31 +212,36 @@ int8_t follow_up_read(){
   *
   * @retval 0 or -1, reflecting whether or not the operation has succeeded
 */
-int8_t daily_read(){
+FAULT_HOT_CODE int8_t daily_read(){
+
+    if (state->pass_num >= g_const_PASS_REQ * read_error_pass_constant){
 
-    if (pass_num >= g_const_PASS_REQ * read_error_pass_constant){
+        //A follow-up read is pending; hold the daily check so both are served by one verification
+        if (g_read_error == 1 || recovery_is_pending(RECOVERY_PWR_MON_REREAD)){
+            return 0;
+        }
         
-        pass_num = 0;
+        state->pass_num = 0;
 
-        if (temp_check() == ERROR || volt_check() == ERROR || current_check() == ERROR || power_check() == ERROR){
+        if (verify_pwr_mon_registers() == ERROR){
     
-            if (last_test_failed == TRUE){
+            if (state->last_test_failed == TRUE){
 
-                last_test_failed = FALSE;
+                state->last_test_failed = FALSE;
                 return ERROR;
 
             } else {
 
-                last_test_failed = TRUE;
+                state->last_test_failed = TRUE;
             }
         } else {
             
-            last_test_failed = FALSE;
+            state->last_test_failed = FALSE;
         }
 
     } else {
 
-        pass_num++;
+        state->pass_num++;
     }
     return 0;
 }
@@ -174,9 +253,13 @@ int8_t daily_read(){
   *
   * @retval None
 */
-void detect_pwr_mon_read_error(){
+FAULT_HOT_CODE void detect_pwr_mon_read_error(){
+
+    fault_corr_tick();
+
+    follow_up_read();
 
-    if (follow_up_read() == ERROR || daily_read() == ERROR){
+    if (daily_read() == ERROR){
 
         handle_pwr_mon_read_error();
     }
@@ -184,7 +267,7 @@ void detect_pwr_mon_read_error(){
 }
 
 /**
-  * @brief handles pwr_mon_read_error, entering safety mode
+  * @brief handles pwr_mon_read_error, queueing safety mode entry
   *
   * @param None
   *
@@ -192,6 +275,5 @@ void detect_pwr_mon_read_error(){
 */
 void handle_pwr_mon_read_error(){
     
-    printf("Entering Safety Mode\n");
-    printf("Fault: pwr_mon_read_error\n");
+    recovery_post(RECOVERY_SAFETY_MODE_PWR_MON_READ_ERROR);
 }
@@ -1,6 +1,6 @@
 /*
  * Date Created: 07/09/24
- * Last Modified: 14/09/24
+ * Last Modified: 18/10/26
  *
  * Header file for EPS fault detection: pwr_mon_read_error
  * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
@@ -14,8 +14,11 @@
 
 #include <stdint.h>
 #include <string.h>
+#include "detector_state.h"
+#include "chronic_idle.h"
 
-extern uint8_t g_read_error; //Flag for recent failure to read device
+#define g_read_error (g_detector_state.pwr_mon_read_error.read_error) //Flag for recent failure to read device
+#define READ_ERROR_DELAY (g_const_PASS_REQ*60) //Software loop based delay equivalent to ~1 hour
 
 
 /************** FUNCTION DEFS **************/
@@ -57,13 +60,33 @@ int8_t current_check();
 int8_t power_check();
 
 /**
-  * @brief if power monitor has previously failed to check a register, attemps to check registers again after a delay
+  * @brief attempts to check every power monitor register, skipping registers another detector has
+  * recently read successfully, then records the root cause of any failures
   *
   * @param None
   *
   * @retval 0 or -1, reflecting whether or not the operation has been successful
 */
-int8_t follow_up_read();
+int8_t verify_pwr_mon_registers();
+
+/**
+  * @brief if power monitor has previously failed to check a register, queues a re-read of the registers after a delay;
+  * the re-read itself runs from 'recovery_drain' via 'run_follow_up_read'
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void follow_up_read();
+
+/**
+  * @brief runs the queued follow-up read; a passing follow-up also serves as a daily check held back for it
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void run_follow_up_read();
 
 /**
   * @brief checks daily if power monitor registers are operational
@@ -84,7 +107,7 @@ int8_t daily_read();
 void detect_pwr_mon_read_error();
 
 /**
-  * @brief handles pwr_mon_read_error, entering safety mode
+  * @brief handles pwr_mon_read_error, queueing safety mode entry
   *
   * @param None
   *
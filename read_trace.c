@@ -0,0 +1,206 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Source file for EPS fault diagnostics: read_trace
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Records every power monitor and MPPT read result into a circular buffer which can be dumped without copying
+ * and replayed on host through the unmodified fault detectors (see 'read_trace_replay.c').
+ *
+ * Author(s): Winston Fournier
+ */
+
+#include "read_trace.h"
+#include <string.h>
+
+#ifdef USE_HAL_DRIVER
+#include "main.h"
+#endif
+
+#ifdef READ_TRACE_ENABLE
+
+static read_trace_record_t records[READ_TRACE_SZ]; //Circular buffer of recorded reads
+static uint16_t next_pos = 0; //Position the next record is written to
+static uint32_t total_records = 0; //Number of records written since the last reset
+
+typedef struct {
+    detector_state_t state; //Detector state at the start of a main loop pass
+    uint32_t first_record; //'total_records' when the snapshot was taken
+} read_trace_snapshot_t;
+
+//Snapshots are taken alternately every half buffer, so one always precedes at least half the retained records
+static read_trace_snapshot_t snapshots[2];
+static uint8_t newest_snapshot = 1; //Snapshot written last; the next one overwrites the other
+static uint8_t snapshot_count = 0; //Number of valid snapshots
+
+
+/**
+  * @brief records a driver read result, overwriting the oldest record once the buffer is full
+  *
+  * @param source read_trace_src of the driver call
+  * @param value raw value returned by the driver
+  * @param out_message status message written by the driver, or NULL if the driver has none
+  *
+  * @retval None
+*/
+void read_trace_record(uint8_t source, int32_t value, const char *out_message){
+
+    read_trace_record_t *record = &records[next_pos];
+
+#ifdef USE_HAL_DRIVER
+    record->timestamp = HAL_GetTick();
+#else
+    record->timestamp = total_records;
+#endif
+    record->value = value;
+    record->source = source;
+    record->status = 0;
+    record->reserved = 0;
+
+    if (out_message != NULL && strncmp(out_message, "ERROR", 5) == 0){
+        record->status = (uint8_t)out_message[5];
+    }
+
+    next_pos++;
+    if (next_pos == READ_TRACE_SZ){
+        next_pos = 0;
+    }
+    total_records++;
+}
+
+/**
+  * @brief snapshots the detector state at a pass boundary so a dump can be replayed from its oldest record;
+  * call at the top of every main loop pass, before the detectors
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void read_trace_pass_start(){
+
+    if (snapshot_count > 0 && total_records - snapshots[newest_snapshot].first_record < READ_TRACE_SZ/2){
+        return;
+    }
+
+    newest_snapshot ^= 1;
+    memcpy(&snapshots[newest_snapshot].state, &g_detector_state, sizeof(g_detector_state));
+    snapshots[newest_snapshot].first_record = total_records;
+
+    if (snapshot_count < 2){
+        snapshot_count++;
+    }
+}
+
+/**
+  * @brief locates the newest 'count' records in place as up to two contiguous spans, oldest first
+  *
+  * @param count number of records, at most the number retained
+  * @param first set to the oldest span of records
+  * @param first_len set to the number of records in 'first'
+  * @param second set to the newer span of records, or NULL if the records do not wrap
+  * @param second_len set to the number of records in 'second'
+  *
+  * @retval None
+*/
+static void newest_spans(uint16_t count, const read_trace_record_t **first, uint16_t *first_len,
+        const read_trace_record_t **second, uint16_t *second_len){
+
+    if (count <= next_pos){
+
+        *first = &records[next_pos - count];
+        *first_len = count;
+        *second = NULL;
+        *second_len = 0;
+
+    } else {
+
+        *first = &records[READ_TRACE_SZ - (count - next_pos)];
+        *first_len = count - next_pos;
+        *second = records;
+        *second_len = next_pos;
+    }
+}
+
+/**
+  * @brief discards all recorded reads
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void read_trace_reset(){
+
+    next_pos = 0;
+    total_records = 0;
+    snapshot_count = 0;
+}
+
+/**
+  * @brief provides the recorded reads in place as up to two contiguous spans, oldest first
+  *
+  * @param first set to the oldest span of records
+  * @param first_len set to the number of records in 'first'
+  * @param second set to the newer span of records, or NULL if the buffer has not wrapped
+  * @param second_len set to the number of records in 'second'
+  *
+  * @retval None
+*/
+void read_trace_spans(const read_trace_record_t **first, uint16_t *first_len,
+        const read_trace_record_t **second, uint16_t *second_len){
+
+    newest_spans(total_records < READ_TRACE_SZ ? total_records : READ_TRACE_SZ, first, first_len, second, second_len);
+}
+
+/**
+  * @brief writes a header, the detector state snapshot and every read recorded since that snapshot to 'write',
+  * straight from the circular buffer; reads older than the snapshot cannot be replayed and are left out
+  *
+  * @param write sink for the dumped bytes
+  *
+  * @retval None
+*/
+void read_trace_dump(read_trace_write_fn write){
+
+    const read_trace_record_t *first;
+    const read_trace_record_t *second;
+    const detector_state_t *state = &g_detector_state;
+    uint16_t first_len;
+    uint16_t second_len;
+    uint16_t count = 0;
+    read_trace_header_t header;
+    uint32_t oldest_record = total_records < READ_TRACE_SZ ? 0 : total_records - READ_TRACE_SZ;
+
+    if (snapshot_count > 0){
+
+        //Prefer the older snapshot while every record after it is still retained
+        const read_trace_snapshot_t *snapshot = &snapshots[newest_snapshot];
+        if (snapshot_count == 2 && snapshots[newest_snapshot ^ 1].first_record >= oldest_record){
+            snapshot = &snapshots[newest_snapshot ^ 1];
+        }
+
+        if (snapshot->first_record >= oldest_record){
+            state = &snapshot->state;
+            count = total_records - snapshot->first_record;
+        }
+    }
+
+    newest_spans(count, &first, &first_len, &second, &second_len);
+
+    header.magic = READ_TRACE_MAGIC;
+    header.version = READ_TRACE_VERSION;
+    header.record_size = sizeof(read_trace_record_t);
+    header.count = count;
+    header.dropped = total_records - count;
+
+    write(&header, sizeof(header));
+    write(state, sizeof(detector_state_t));
+
+    if (first_len > 0){
+        write(first, first_len * sizeof(read_trace_record_t));
+    }
+    if (second_len > 0){
+        write(second, second_len * sizeof(read_trace_record_t));
+    }
+}
+
+#endif // READ_TRACE_ENABLE
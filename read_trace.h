@@ -0,0 +1,122 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Header file for EPS fault diagnostics: read_trace
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Records every power monitor and MPPT read result into a circular buffer which can be dumped without copying
+ * and replayed on host through the unmodified fault detectors (see 'read_trace_replay.c').
+ *
+ * Author(s): Winston Fournier
+ */
+
+#ifndef READ_TRACE_H_
+#define READ_TRACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "detector_state.h"
+
+#define READ_TRACE_MAGIC 0x52545045 //"EPTR"; marks the start of a trace dump
+#define READ_TRACE_VERSION 2 //Bump whenever the dump layout or 'read_trace_record_t' changes
+#ifndef READ_TRACE_SZ
+//Tentative number of records kept, at 12 bytes each: ~8h of detector reads, but only ~1h with POWER_BLOCK_SAMPLING,
+//whose bursts add POWER_BLOCK_SZ - 1 power reads per minute
+#define READ_TRACE_SZ 1024
+#endif
+
+typedef enum {
+    READ_TRACE_SRC_TEMP = 0, //eps_get_power_monitor_temp_func
+    READ_TRACE_SRC_V_BUS = 1, //eps_get_power_monitor_v_bus_val_func
+    READ_TRACE_SRC_CURRENT = 2, //eps_get_power_monitor_current_func
+    READ_TRACE_SRC_POWER = 3, //eps_get_power_monitor_power_func
+    READ_TRACE_SRC_MPPT = 4 //mppt_get_charge_status
+} read_trace_src;
+
+typedef struct {
+    uint32_t timestamp; //HAL tick in ms on target, record sequence number on host
+    int32_t value; //Raw value returned by the driver
+    uint8_t source; //read_trace_src of the driver call
+    uint8_t status; //0 on success, otherwise the register letter of the driver's "ERROR?\r\n" message
+    uint16_t reserved;
+} read_trace_record_t;
+
+typedef struct {
+    uint32_t magic; //READ_TRACE_MAGIC
+    uint16_t version; //READ_TRACE_VERSION
+    uint16_t record_size; //sizeof(read_trace_record_t)
+    uint32_t count; //Number of records following the header and state snapshot, oldest first
+    uint32_t dropped; //Number of records overwritten, or older than the snapshot, before the dump
+} read_trace_header_t; //Followed by the 'detector_state_t' at the start of the pass of the first record
+
+typedef void (*read_trace_write_fn)(const void *data, uint32_t len); //Sink for dumped bytes, e.g. a UART transmit
+
+
+/************** FUNCTION DEFS **************/
+
+#ifdef READ_TRACE_ENABLE
+
+/**
+  * @brief records a driver read result, overwriting the oldest record once the buffer is full
+  *
+  * @param source read_trace_src of the driver call
+  * @param value raw value returned by the driver
+  * @param out_message status message written by the driver, or NULL if the driver has none
+  *
+  * @retval None
+*/
+void read_trace_record(uint8_t source, int32_t value, const char *out_message);
+
+/**
+  * @brief snapshots the detector state at a pass boundary so a dump can be replayed from its oldest record;
+  * call at the top of every main loop pass, before the detectors
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void read_trace_pass_start();
+
+/**
+  * @brief discards all recorded reads
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void read_trace_reset();
+
+/**
+  * @brief provides the recorded reads in place as up to two contiguous spans, oldest first
+  *
+  * @param first set to the oldest span of records
+  * @param first_len set to the number of records in 'first'
+  * @param second set to the newer span of records, or NULL if the buffer has not wrapped
+  * @param second_len set to the number of records in 'second'
+  *
+  * @retval None
+*/
+void read_trace_spans(const read_trace_record_t **first, uint16_t *first_len,
+        const read_trace_record_t **second, uint16_t *second_len);
+
+/**
+  * @brief writes a header, the detector state snapshot and every read recorded since that snapshot to 'write',
+  * straight from the circular buffer
+  *
+  * @param write sink for the dumped bytes
+  *
+  * @retval None
+*/
+void read_trace_dump(read_trace_write_fn write);
+
+#else
+//Tracing compiled out: no buffer is allocated, nothing is recorded and a dump writes nothing
+#define read_trace_record(source, value, out_message) ((void)(value))
+#define read_trace_pass_start() ((void)0)
+#define read_trace_reset() ((void)0)
+#define read_trace_spans(first, first_len, second, second_len) \
+    (*(first) = NULL, *(first_len) = 0, *(second) = NULL, *(second_len) = 0)
+#define read_trace_dump(write) ((void)(write))
+#endif // READ_TRACE_ENABLE
+
+#endif // READ_TRACE_H_
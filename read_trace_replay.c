@@ -0,0 +1,197 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Source file for EPS fault diagnostics: read_trace_replay (host only)
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Replays a 'read_trace' dump through the unmodified fault detectors by standing in for the power monitor
+ * and MPPT drivers. Build on host together with the detector sources, e.g.
+ * gcc -o read_trace_replay read_trace_replay.c read_trace.c detector_state.c chronic_idle.c source_decay.c pwr_mon_read_error.c \
+ *     recovery_queue.c power_block.c fault_correlation.c
+ * and run with 'read_trace_replay <trace dump>'. Detector state starts from the snapshot carried in the dump,
+ * taken at the start of the pass which made the first record.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#ifndef USE_HAL_DRIVER
+
+#include "read_trace.h"
+#include "detector_state.h"
+#include "chronic_idle.h"
+#include "source_decay.h"
+#include "pwr_mon_read_error.h"
+#include "recovery_queue.h"
+#include "fault_correlation.h"
+#include "mppt.h"
+#include "load_switches.h"
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static read_trace_record_t *trace = NULL; //Records loaded from the dump, oldest first
+static uint32_t trace_len = 0; //Number of records in 'trace'
+static uint32_t trace_pos = 0; //Next record handed to a driver call
+static jmp_buf replay_end; //Unwinds out of the current pass once the trace is exhausted or has diverged
+static uint32_t divergences = 0; //Driver calls which did not match the next recorded source
+
+
+/**
+  * @brief loads a trace dump written by 'read_trace_dump', restoring the detector state snapshot it carries
+  *
+  * @param path path of the dump file
+  *
+  * @retval 0 or -1, indicating operation success or ERROR respectively
+*/
+static int8_t load_trace(const char *path){
+
+    read_trace_header_t header;
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL){
+        return ERROR;
+    }
+
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != READ_TRACE_MAGIC
+            || header.version != READ_TRACE_VERSION || header.record_size != sizeof(read_trace_record_t)){
+        fclose(file);
+        return ERROR;
+    }
+
+    if (fread(&g_detector_state, sizeof(g_detector_state), 1, file) != 1 || g_detector_state.magic != DETECTOR_STATE_MAGIC
+            || g_detector_state.version != DETECTOR_STATE_VERSION || g_detector_state.size != sizeof(detector_state_t)){
+        fclose(file);
+        return ERROR;
+    }
+
+    if (header.count > 0){
+
+        trace = malloc(header.count * sizeof(read_trace_record_t));
+        if (trace == NULL || fread(trace, sizeof(read_trace_record_t), header.count, file) != header.count){
+            free(trace);
+            trace = NULL;
+            fclose(file);
+            return ERROR;
+        }
+    }
+    fclose(file);
+
+    trace_len = header.count;
+    printf("Loaded %u records (%u dropped before dump)\n", (unsigned)header.count, (unsigned)header.dropped);
+    return 0;
+}
+
+/**
+  * @brief hands the next recorded read to a driver stand-in, reproducing its status message
+  *
+  * @param source read_trace_src of the calling driver
+  * @param out_message status message to fill, or NULL if the driver has none
+  *
+  * @retval raw value recorded for the read; does not return once the trace has ended
+*/
+static int32_t next_read(uint8_t source, char *out_message){
+
+    if (out_message != NULL){
+        out_message[0] = '\0';
+    }
+
+    //The pass in progress is abandoned so no detector acts on a read that was never recorded
+    if (trace_pos >= trace_len){
+        longjmp(replay_end, 1);
+    }
+
+    read_trace_record_t *record = &trace[trace_pos];
+
+    if (record->source != source){
+        printf("Divergence at record %u: detectors read source %u, trace holds source %u\n",
+                (unsigned)trace_pos, source, record->source);
+        divergences++;
+        longjmp(replay_end, 1);
+    }
+    trace_pos++;
+
+    if (out_message != NULL && record->status != 0){
+        sprintf(out_message, "ERROR%c\r\n", record->status);
+    }
+
+    return record->value;
+}
+
+int16_t eps_get_power_monitor_temp_func(uint8_t power_monitor_address, uint8_t device_address, char *out_message){
+
+    return (int16_t)next_read(READ_TRACE_SRC_TEMP, out_message);
+}
+
+int16_t eps_get_power_monitor_v_bus_val_func(uint8_t power_monitor_address, uint8_t device_address, char *out_message){
+
+    return (int16_t)next_read(READ_TRACE_SRC_V_BUS, out_message);
+}
+
+int16_t eps_get_power_monitor_current_func(uint8_t power_monitor_address, uint8_t device_address, char *out_message){
+
+    return (int16_t)next_read(READ_TRACE_SRC_CURRENT, out_message);
+}
+
+int32_t eps_get_power_monitor_power_func(uint8_t power_monitor_address, uint8_t device_address, char *out_message){
+
+    return next_read(READ_TRACE_SRC_POWER, out_message);
+}
+
+eps_mppt_status mppt_get_charge_status(){
+
+    return (eps_mppt_status)next_read(READ_TRACE_SRC_MPPT, NULL);
+}
+
+void mppt_init(){
+
+    printf("Replay: mppt_init at record %u\n", (unsigned)trace_pos);
+}
+
+/**
+  * @brief runs main loop passes (in flight order) until every recorded read has been consumed
+  *
+  * @param argc argument count
+  * @param argv trace dump path
+  *
+  * @retval 0 or 1, indicating every record was replayed or a load failure / divergence respectively
+*/
+int main(int argc, char **argv){
+
+    volatile uint64_t passes = 0;
+
+    if (argc < 2 || load_trace(argv[1]) == ERROR){
+        printf("Usage: %s <trace dump>\n", argv[0]);
+        return 1;
+    }
+
+    clock_t start = clock();
+
+    if (setjmp(replay_end) == 0){
+
+        while (1){
+            detect_chronic_idle();
+            detect_source_decay();
+            detect_pwr_mon_read_error();
+            recovery_drain();
+            passes++;
+        }
+    }
+
+    double elapsed_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+    double simulated_s = 60.0 * passes / (g_const_PASS_REQ + 1);
+
+    printf("Replayed %u/%u records over %llu passes (~%.0f s of flight time) in %.3f s",
+            (unsigned)trace_pos, (unsigned)trace_len, (unsigned long long)passes, simulated_s, elapsed_s);
+    if (elapsed_s > 0){
+        printf(", %.0fx real time", simulated_s / elapsed_s);
+    }
+    printf("\n");
+    fault_corr_print_report();
+
+    free(trace);
+    return (divergences == 0 && trace_pos == trace_len) ? 0 : 1;
+}
+
+#endif // USE_HAL_DRIVER
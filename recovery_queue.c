@@ -0,0 +1,106 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Source file for EPS fault recovery: recovery_queue
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Defers recovery actions posted by the fault detectors until a controlled point in the main loop,
+ * running them in priority order with duplicate requests merged.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#include "recovery_queue.h"
+#include "chronic_idle.h"
+#include "mppt.h"
+#include "pwr_mon_read_error.h"
+#include "detector_state.h"
+#include "fault_sections.h"
+#include <stdio.h>
+
+static recovery_queue_state_t *const state = &g_detector_state.recovery_queue;
+
+
+/**
+  * @brief enters safety mode on behalf of a fault case
+  *
+  * @param fault name of the fault case
+  *
+  * @retval None
+*/
+static void enter_safety_mode(const char *fault){
+
+    printf("Entering Safety Mode\n");
+    printf("Fault: %s\n", fault);
+}
+
+/**
+  * @brief queues a recovery action in O(1); an action which is already pending is not queued twice
+  *
+  * @param action recovery_action to queue
+  *
+  * @retval 1 or 0, indicating the action was queued or merged with a pending request respectively
+*/
+uint8_t recovery_post(recovery_action action){
+
+    uint8_t bit = 1 << action;
+
+    if (state->pending & bit){
+        return FALSE;
+    }
+
+    state->pending |= bit;
+    return TRUE;
+}
+
+/**
+  * @brief checks whether a recovery action is waiting to run
+  *
+  * @param action recovery_action to check
+  *
+  * @retval 1 or 0, in the case of TRUE or FALSE respectively
+*/
+uint8_t recovery_is_pending(recovery_action action){
+
+    return (state->pending >> action) & 1;
+}
+
+/**
+  * @brief runs every pending recovery action, highest priority first, including any posted while draining;
+  * call once per main loop pass after the detectors
+  *
+  * @param None
+  *
+  * @retval None
+*/
+FAULT_HOT_CODE void recovery_drain(){
+
+    while (state->pending != 0){
+
+        //Lowest set bit is the highest priority pending action
+        recovery_action action = (recovery_action)__builtin_ctz(state->pending);
+        state->pending &= ~(1 << action);
+
+        switch (action){
+
+            case RECOVERY_SAFETY_MODE_CHRONIC_IDLE:
+                enter_safety_mode("chronic_idle");
+                break;
+
+            case RECOVERY_SAFETY_MODE_PWR_MON_READ_ERROR:
+                enter_safety_mode("pwr_mon_read_error");
+                break;
+
+            case RECOVERY_MPPT_REINIT:
+                mppt_init();
+                break;
+
+            case RECOVERY_PWR_MON_REREAD:
+                run_follow_up_read();
+                break;
+
+            default:
+                break;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * Date Created: 18/10/26
+ * Last Modified: 18/10/26
+ *
+ * Header file for EPS fault recovery: recovery_queue
+ * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
+ * Defers recovery actions posted by the fault detectors until a controlled point in the main loop,
+ * running them in priority order with duplicate requests merged.
+ *
+ * Author(s): Winston Fournier
+ */
+
+#ifndef RECOVERY_QUEUE_H_
+#define RECOVERY_QUEUE_H_
+
+#include <stdint.h>
+
+//Each action owns one bit of the pending mask; lower values run first
+typedef enum {
+    RECOVERY_SAFETY_MODE_CHRONIC_IDLE = 0, //Enter safety mode for fault chronic_idle
+    RECOVERY_SAFETY_MODE_PWR_MON_READ_ERROR = 1, //Enter safety mode for fault pwr_mon_read_error
+    RECOVERY_MPPT_REINIT = 2, //Power cycle the MPPT via mppt_init()
+    RECOVERY_PWR_MON_REREAD = 3, //Re-read every power monitor register to verify an earlier read error
+    RECOVERY_ACTION_COUNT = 4
+} recovery_action;
+
+
+/************** FUNCTION DEFS **************/
+
+/**
+  * @brief queues a recovery action in O(1); an action which is already pending is not queued twice
+  *
+  * @param action recovery_action to queue
+  *
+  * @retval 1 or 0, indicating the action was queued or merged with a pending request respectively
+*/
+uint8_t recovery_post(recovery_action action);
+
+/**
+  * @brief checks whether a recovery action is waiting to run
+  *
+  * @param action recovery_action to check
+  *
+  * @retval 1 or 0, in the case of TRUE or FALSE respectively
+*/
+uint8_t recovery_is_pending(recovery_action action);
+
+/**
+  * @brief runs every pending recovery action, highest priority first, including any posted while draining;
+  * call once per main loop pass after the detectors
+  *
+  * @param None
+  *
+  * @retval None
+*/
+void recovery_drain();
+
+#endif // RECOVERY_QUEUE_H_
@@ -1,6 +1,6 @@
 /*
  * Date Created: 19/08/24
- * Last Modified: 08/09/24
+ * Last Modified: 18/10/26
  *
  * Header file for EPS fault detection: source_decay
  * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
@@ -12,24 +12,21 @@
 #include "source_decay.h"
 #include "chronic_idle.h"
 #include "pwr_mon_read_error.h"
+#include "detector_state.h"
+#include "read_trace.h"
+#include "power_block.h"
+#include "fault_correlation.h"
+#include "fault_sections.h"
 
 #define MAXIMUM_EXPECTED_CURRENT 32768 //Placeholder: unspecified on data sheet
-#define MONTHS_LOG_SZ 128 //Tentative size of log of monthly rolling averages
-
-static uint16_t pass_num = 0; //counter tracking iterations of the while loop, gets reset when 'pass_num == g_const_PASS_REQ'
-static float minutes_roll_avg = 0; //rolling average of power readings over an hour
-static float hours_roll_avg = 0; //rolling average of power readings over a day
-static float days_roll_avg = 0; //rolling average of power readings over a month
-static float months_log[MONTHS_LOG_SZ] = {0}; //log of monthly rolling averages
-static uint8_t minutes_pos = 0; //counter tracking number of readings logged for minutes_roll_avg
-static uint8_t hours_pos = 0; //counter tracking number of readings logged for hours_roll_avg
-static uint8_t days_pos = 0; //counter tracking number of readings logged for days_roll_avg
-static uint8_t months_pos = 0; //counter tracking the next available position for logging in months_log
-static float baseline_avg = 0; //records month 1 average power; sets baseline for future monthly comparisons
+
+static source_decay_state_t *const state = &g_detector_state.source_decay; //Persistent rolling averages and counters, see 'detector_state.h'
 static int32_t raw_power_val; //records raw power value provided by the power monitor
-static uint8_t perform_monthly_check = FALSE; //flags when a new monthly average is ready to be compared to the baseline_avg
+#ifdef POWER_BLOCK_SAMPLING
+#define POWER_BLOCK_MIN_GOOD 3 //Fewest successful samples the trimmed mean is taken over
+static uint16_t power_block[POWER_BLOCK_SZ]; //burst of raw power readings reduced to one value before logging
+#endif
 static const float CAP_THRESHOLD = 0.8; //tentative threshold of source capability (80%) whereby handler kicks in
-uint8_t g_source_decay = 0;
 
 
 /**
@@ -39,7 +36,7 @@ uint8_t g_source_decay = 0;
   *
   * @retval None
 */
-float CURRENT_LSB(){
+FAULT_HOT_CODE float CURRENT_LSB(){
 
     return MAXIMUM_EXPECTED_CURRENT / 32768;
 
@@ -52,62 +49,110 @@ float CURRENT_LSB(){
   *
   * @retval None
 */
-float convert_raw_to_watts(int32_t raw_power_val){
+FAULT_HOT_CODE float convert_raw_to_watts(int32_t raw_power_val){
 
     return 0.2 * CURRENT_LSB() * raw_power_val; //data sheet hardware-specified conversion factor
 
 }
 
 /**
-  * @brief logs current power to the appropriate log or rolling average; data is aggregated over time to conserve memory
+  * @brief reads raw power into 'raw_power_val'; with POWER_BLOCK_SAMPLING, reads a burst of POWER_BLOCK_SZ samples
+  * and keeps the trimmed mean of those read successfully, so a single glitch or failed read does not cost the period
   * 
   * @param None
   *
   * @retval 0 or -1, indicating operation success or ERROR respectively
 */
-int8_t log_current_power(){
+static int8_t read_raw_power(){
 
     char out_message[50];
+
+#ifdef POWER_BLOCK_SAMPLING
+    uint16_t good = 0;
+
+    for (uint16_t i = 0; i < POWER_BLOCK_SZ; i++){
+
+        int32_t raw_sample = eps_get_power_monitor_power_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+        read_trace_record(READ_TRACE_SRC_POWER, raw_sample, out_message);
+        fault_corr_observe(PWR_MON_REG_POWER, FAULT_CORR_SOURCE_DECAY, out_message);
+
+        //Failed samples are left out of the block; the evidence still reaches fault_correlation
+        if (strcmp(out_message, "ERRORP\r\n") == 0){
+            continue;
+        }
+
+        //data sheet: power register is 16 bits wide; anything outside it is a corrupt read, not a value to truncate
+        if (raw_sample < 0 || raw_sample > 0xFFFF){
+            continue;
+        }
+        power_block[good++] = (uint16_t)raw_sample;
+    }
+
+    if (good < POWER_BLOCK_MIN_GOOD){
+        return ERROR;
+    }
+
+    raw_power_val = power_block_reduce(power_block, good);
+#else
     raw_power_val = eps_get_power_monitor_power_func(POWER_MONITOR_ADDRESS, SECONDARY_DEVICE_ADDRESS, out_message);
+    read_trace_record(READ_TRACE_SRC_POWER, raw_power_val, out_message);
+    fault_corr_observe(PWR_MON_REG_POWER, FAULT_CORR_SOURCE_DECAY, out_message);
 
     if (strcmp(out_message, "ERRORP\r\n") == 0){
         return ERROR;
+    }
+#endif
+
+    return 0;
+}
+
+/**
+  * @brief logs current power to the appropriate log or rolling average; data is aggregated over time to conserve memory
+  * 
+  * @param None
+  *
+  * @retval 0 or -1, indicating operation success or ERROR respectively
+*/
+int8_t log_current_power(){
+
+    if (read_raw_power() == ERROR){
+        return ERROR;
 
     } else {
-        minutes_roll_avg += convert_raw_to_watts(raw_power_val);
-        minutes_pos++;
+        state->minutes_roll_avg += convert_raw_to_watts(raw_power_val);
+        state->minutes_pos++;
 
-        if (minutes_pos == 60){
-            minutes_pos = 0;
+        if (state->minutes_pos == 60){
+            state->minutes_pos = 0;
 
-            hours_roll_avg += minutes_roll_avg / 60;
-            minutes_roll_avg = 0;
-            hours_pos++;
+            state->hours_roll_avg += state->minutes_roll_avg / 60;
+            state->minutes_roll_avg = 0;
+            state->hours_pos++;
 
-            if (hours_pos == 24){
-                hours_pos = 0;
+            if (state->hours_pos == 24){
+                state->hours_pos = 0;
 
-                days_roll_avg += hours_roll_avg / 24;
-                hours_roll_avg = 0;
-                days_pos++;
+                state->days_roll_avg += state->hours_roll_avg / 24;
+                state->hours_roll_avg = 0;
+                state->days_pos++;
 
-                if (days_pos == 30){
-                    days_pos = 0;
+                if (state->days_pos == 30){
+                    state->days_pos = 0;
 
-                    months_log[months_pos] = days_roll_avg / 30;
-                    days_roll_avg = 0;
+                    state->months_log[state->months_pos] = state->days_roll_avg / 30;
+                    state->days_roll_avg = 0;
 
-                    if (baseline_avg == 0){
-                        baseline_avg = months_log[months_pos];
+                    if (state->baseline_avg == 0){
+                        state->baseline_avg = state->months_log[state->months_pos];
 
                     } else {
-                        perform_monthly_check = TRUE;
+                        state->perform_monthly_check = TRUE;
 
                     }
-                    months_pos++;
+                    state->months_pos++;
 
-                    if (months_pos == MONTHS_LOG_SZ){
-                        months_pos = 0;
+                    if (state->months_pos == MONTHS_LOG_SZ){
+                        state->months_pos = 0;
                     }
                 }
             }
@@ -124,13 +169,13 @@ int8_t log_current_power(){
   *
   * @retval None
 */
-void detect_source_decay(){
+FAULT_HOT_CODE void detect_source_decay(){
 
     if (g_source_decay != 1){
         
-        if (pass_num < g_const_PASS_REQ){
+        if (state->pass_num < g_const_PASS_REQ){
             
-            pass_num++;
+            state->pass_num++;
 
         } else {
 
@@ -140,18 +185,18 @@ void detect_source_decay(){
 
             } else {
 
-                if (perform_monthly_check == TRUE){
+                if (state->perform_monthly_check == TRUE){
                 
-                    if (months_log[months_pos] < baseline_avg * CAP_THRESHOLD){
+                    if (state->months_log[state->months_pos] < state->baseline_avg * CAP_THRESHOLD){
 
                         handle_source_decay();
 
                     }
-                    perform_monthly_check = FALSE;
+                    state->perform_monthly_check = FALSE;
 
                 }
             }
-            pass_num = 0;
+            state->pass_num = 0;
         }
     }
 }
@@ -1,6 +1,6 @@
 /*
  * Date Created: 19/08/24
- * Last Modified: 08/09/24
+ * Last Modified: 18/10/26
  *
  * Header file for EPS fault detection: source_decay
  * Used in fault detection firmware for a CubeSat Electrical Power System (EPS).
@@ -13,8 +13,9 @@
 #define SOURCE_DECAY_H_
 
 #include <stdint.h>
+#include "detector_state.h"
 
-extern uint8_t g_source_decay; //Global flag for occurence of 'source_decay' fault
+#define g_source_decay (g_detector_state.source_decay.source_decay) //Global flag for occurence of 'source_decay' fault
 
 
 /************** FUNCTION DEFS **************/